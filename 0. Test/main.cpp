@@ -1,12 +1,7 @@
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
 
-#include <iostream>
 #include <cmath>
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
@@ -26,165 +21,86 @@ const char *fragmentShaderSource = "#version 330 core\n"
     "   FragColor = ourColor;\n"
     "}\n\0";
 
-int main()
+int main(int argc, char** argv)
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    // --lazy: a cleared frame on screen before anything below is built (common/include/gl_startup.h)
+    GlContextSettings settings;
+    settings.width = SCR_WIDTH;
+    settings.height = SCR_HEIGHT;
+    settings.title = "LearnOpenGL";
+    settings.lazyStartup = lazyStartupArgument(argc, argv);
+    // --gles [--color-format rgb565|rgba4]: an OpenGL ES 3.0 context, and 16-bit color for a tiled GPU's bandwidth (common/include/gl_context.h)
+    settings.gles = glesArgument(argc, argv);
+    settings.colorFormat = colorFormatArgument(argc, argv);
+    GlContext context;
+    if (!context.open(settings))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // --fps N: deterministic offline mode, the animation stepped exactly 1 / N a frame (common/include/frame_clock.h)
+    context.setFixedRate(fixedRateArgument(argc, argv));
+    // --pacing vsync|adaptive|low-latency|throughput|power-save [--cap N] (common/include/frame_pacer.h)
+    context.setPacing(pacingArgument(argc, argv), frameCapArgument(argc, argv));
+    // --render-thread: frames drawn on their own thread, this one only pumps the window's events (common/include/gl_context.h)
+    context.setRenderThread(renderThreadArgument(argc, argv));
+    context.setHud(hudArgument(argc, argv));
+    // --screenshot file.png [--screenshot-frame N], or F12 while it runs: a frame written in the background (common/include/gl_context.h)
+    context.screenshot(screenshotArgument(argc, argv), screenshotFrameArgument(argc, argv));
+    // --aa none|fxaa|msaa2|msaa4|msaa8: the quality tier the frames are drawn with (common/include/gl_antialias.h)
+    context.setAntialiasing(antialiasingArgument(argc, argv));
+
+    // build and compile our shader program (common/include/gl_shader.h)
+    // ------------------------------------------------------------------
+    GlProgram shaderProgram;
+    if (settings.lazyStartup)
+        shaderProgram.buildLater(vertexShaderSource, fragmentShaderSource);   // the frames clear only, until it is linked
+    else if (!shaderProgram.build(vertexShaderSource, fragmentShaderSource))
         return -1;
-    }
-
-    // build and compile our shader program
-    // ------------------------------------
-    // vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
     float vertices[] = {
          0.5f, -0.5f, 0.0f,  // bottom right
         -0.5f, -0.5f, 0.0f,  // bottom left
-         0.0f,  0.5f, 0.0f   // top 
+         0.0f,  0.5f, 0.0f   // top
     };
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    // glBindVertexArray(0);
-
+    GlVertexArray VAO;
+    VAO.vertices(vertices, sizeof(vertices));
+    VAO.attribute(0, 3, 3 * sizeof(float), 0);
 
-    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can 
+    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can
     // just bind it beforehand before rendering the respective triangle; this is another approach.
-    glBindVertexArray(VAO);
+    VAO.bind();
 
+    // uniform locations, looked up once (when the program is ready) instead of every frame
+    GlUniform ourColor;
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
+        if (!shaderProgram.poll())
+            return;
+        if (!ourColor.isActive())
+            ourColor = shaderProgram.uniform("ourColor");
 
         // be sure to activate the shader before any calls to glUniform
-        glUseProgram(shaderProgram);
+        shaderProgram.use();
 
         // update shader uniform
-        double  timeValue = glfwGetTime();
+        double  timeValue = context.time();
         float greenValue = static_cast<float>(sin(timeValue) / 2.0 + 0.5);
-        int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
-        glUniform4f(vertexColorLocation, 0.0f, greenValue, 0.0f, 1.0f);
+        ourColor.set(0.0f, greenValue, 0.0f, 1.0f);
 
         // render the triangle
         glDrawArrays(GL_TRIANGLES, 0, 3);
+    });
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
-
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
 }
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
-}
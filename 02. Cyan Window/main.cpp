@@ -1,10 +1,4 @@
-#include "glad.h"
-#include "glfw3.h"
-
-#include <iostream>
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
+#include "gl_runtime.h"
 
 // settings
 const unsigned int SCR_WIDTH = 800;
@@ -12,73 +6,23 @@ const unsigned int SCR_HEIGHT = 600;
 
 int main()
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef _APPLE_
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Tamim Iqbal", NULL, NULL); //Here you can put any name as window name
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContextSettings settings;
+    settings.width = SCR_WIDTH;
+    settings.height = SCR_HEIGHT;
+    settings.title = "Tamim Iqbal"; //Here you can put any name as window name
+    settings.closeKey = GLFW_KEY_T; // GLFW_KEY_ESCAPE changed by GLFW_KEY_T, where T represents the escape key
+    GlContext context;
+    if (!context.open(settings))
         return -1;
-    }    
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         glClearColor(0.0f, 1.0f, 1.0f, 1.0f);  // Cyan color code 0.0f, 1.0f, 1.0f, 1.0f
         glClear(GL_COLOR_BUFFER_BIT);
-
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
+    });
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if(glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) // GLFW_KEY_ESCAPE changed by GLFW_KEY_T, where T represents the escape key
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
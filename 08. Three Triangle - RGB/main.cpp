@@ -1,233 +1,74 @@
-#include "glad.h"
-#include "glfw3.h"
-
-#include <iostream>
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
+#include "gl_runtime.h"
 
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-const char *vertexShaderSource = "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
-    "void main()\n"
-    "{\n"
-    "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-    "}\0";
-const char *fragmentShader1Source = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(0.0f, 0.0f, 1.0f, 1.0f);\n"
-    "}\n\0";
-const char *fragmentShader2Source = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(0.0f, 1.0f, 0.0f, 1.0f);\n"
-    "}\n\0";
-const char *fragmentShader3Source = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(1.0f, 0.0f, 0.0f, 1.0f);\n"
-    "}\n\0";
-
-
-
 int main()
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // build and compile our shader program: the color comes with every vertex, so one program
+    // draws all three triangles (common/include/gl_batch.h)
+    // -----------------------------------------------------------------------------------------
+    GlProgram shaderProgram;
+    if (!shaderProgram.build(GlPrimitiveBatch::vertexShaderSource, GlPrimitiveBatch::fragmentShaderSource))
         return -1;
-    }
-
-
-    // build and compile our shader program
-    // ------------------------------------
-    // we skipped compile log checks this time for readability (if you do encounter issues, add the compile-checks! see previous code samples)
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    unsigned int fragmentShaderBlue = glCreateShader(GL_FRAGMENT_SHADER); // the first fragment shader that outputs the color Blue
-    unsigned int fragmentShaderGreen = glCreateShader(GL_FRAGMENT_SHADER); // the second fragment shader that outputs the color Green
-    unsigned int fragmentShaderRed = glCreateShader(GL_FRAGMENT_SHADER); // the third fragment shader that outputs the color Red
-
-    unsigned int shaderProgramBlue = glCreateProgram();
-    unsigned int shaderProgramGreen = glCreateProgram(); // the second shader program
-    unsigned int shaderProgramRed = glCreateProgram(); // the third shader program
-
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    glShaderSource(fragmentShaderBlue, 1, &fragmentShader1Source, NULL);
-    glCompileShader(fragmentShaderBlue);
-    glShaderSource(fragmentShaderGreen, 1, &fragmentShader2Source, NULL);
-    glCompileShader(fragmentShaderGreen);
-    glShaderSource(fragmentShaderRed, 1, &fragmentShader3Source, NULL);
-    glCompileShader(fragmentShaderRed);
-
-    // link the first program object
-    glAttachShader(shaderProgramBlue, vertexShader);
-    glAttachShader(shaderProgramBlue, fragmentShaderBlue);
-    glLinkProgram(shaderProgramBlue);
-    // then link the second program object using a different fragment shader (but same vertex shader)
-    // this is perfectly allowed since the inputs and outputs of both the vertex and fragment shaders are equally matched.
-    glAttachShader(shaderProgramGreen, vertexShader);
-    glAttachShader(shaderProgramGreen, fragmentShaderGreen);
-    glLinkProgram(shaderProgramGreen);
-
-    glAttachShader(shaderProgramRed, vertexShader);
-    glAttachShader(shaderProgramRed, fragmentShaderRed);
-    glLinkProgram(shaderProgramRed);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
     /*float vertices[] = {
-       
-        -0.5f, -0.5f, 0.0f, // left  
-         0.5f, -0.5f, 0.0f, // right 
+
+        -0.5f, -0.5f, 0.0f, // left
+         0.5f, -0.5f, 0.0f, // right
          -0.5f,  0.5f, 0.0f ,
-          0.5f,  0.5f, 0.0f,// top 
-          0.5f, -0.5f, 0.0f, // right 
+          0.5f,  0.5f, 0.0f,// top
+          0.5f, -0.5f, 0.0f, // right
          -0.5f,  0.5f, 0.0f
-          
+
     }; */
     float firstTriangle[] = {
-        -0.5f, -0.5f, 0.0f,  // left 
+        -0.5f, -0.5f, 0.0f,  // left
         0.0f, 0.0f, 0.0f,  // right
-        0.5f, -0.5f, 0.0f,  // top 
+        0.5f, -0.5f, 0.0f,  // top
     };
     float secondTriangle[] = {
         0.5f, -0.5f, 0.0f,  // left
         0.0f, 0.0f, 0.0f,  // right
-        0.0f, 0.5f, 0.0f   // top 
+        0.0f, 0.5f, 0.0f   // top
     };
     float thirdTriangle[] = {
         -0.5f, -0.5f, 0.0f,  // left
         0.0f, 0.0f, 0.0f,  // right
-        0.0f, 0.5f, 0.0f   // top 
+        0.0f, 0.5f, 0.0f   // top
     };
-    unsigned int VBOs[3], VAOs[3];
-    glGenVertexArrays(3, VAOs); // we can also generate multiple VAOs or buffers at the same time
-    glGenBuffers(3, VBOs);
-    // first triangle setup
-    // --------------------
-    glBindVertexArray(VAOs[0]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(firstTriangle), firstTriangle, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);	// Vertex attributes stay the same
-    glEnableVertexAttribArray(0);
-    // glBindVertexArray(0); // no need to unbind at all as we directly bind a different VAO the next few lines
-    // second triangle setup
-    // ---------------------
-    glBindVertexArray(VAOs[1]);	// note that we bind to a different VAO now
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[1]);	// and a different VBO
-    glBufferData(GL_ARRAY_BUFFER, sizeof(secondTriangle), secondTriangle, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); // because the vertex data is tightly packed we can also specify 0 as the vertex attribute's stride to let OpenGL figure it out
-    glEnableVertexAttribArray(0);
-    // glBindVertexArray(0); // not really necessary as well, but beware of calls that could affect VAOs while this one is bound (like binding element buffer objects, or enabling/disabling vertex attributes)
-
-
-    //third
-    glBindVertexArray(VAOs[2]);	// note that we bind to a different VAO now
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[2]);	// and a different VBO
-    glBufferData(GL_ARRAY_BUFFER, sizeof(thirdTriangle), thirdTriangle, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); // because the vertex data is tightly packed we can also specify 0 as the vertex attribute's stride to let OpenGL figure it out
-    glEnableVertexAttribArray(0);
-
+    // all three triangles go into one VBO, each with its color; they are drawn in this order
+    GlPrimitiveBatch triangles;
+    triangles.add(firstTriangle, 3, 0.0f, 0.0f, 1.0f);   // Blue
+    triangles.add(secondTriangle, 3, 0.0f, 1.0f, 0.0f);  // Green
+    triangles.add(thirdTriangle, 3, 1.0f, 0.0f, 0.0f);   // Red
+    triangles.upload();
 
     // uncomment this call to draw in wireframe polygons.
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // now when we draw the triangle we first use the vertex and Blue fragment shader from the first program
-        glUseProgram(shaderProgramBlue);
-        // draw the first triangle using the data from our first VAO
-        glBindVertexArray(VAOs[0]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);	// this call should output an Blue triangle
-        // then we draw the second triangle using the data from the second VAO
-        // when we draw the second triangle we want to use a different shader program so we switch to the shader program with our Green fragment shader.
-        glUseProgram(shaderProgramGreen);
-        glBindVertexArray(VAOs[1]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);	// this call should output a Green triangle
-
-
-        //red
-        glUseProgram(shaderProgramRed);
-        glBindVertexArray(VAOs[2]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);	// this call should output a Green triangle
+        // one program, one draw call: the Blue, the Green and then the Red triangle
+        shaderProgram.use();
+        triangles.draw();
+    });
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    glDeleteVertexArrays(3, VAOs);
-    glDeleteBuffers(3, VBOs);
-    glDeleteProgram(shaderProgramBlue);
-    glDeleteProgram(shaderProgramGreen);
-    glDeleteProgram(shaderProgramRed);
-
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
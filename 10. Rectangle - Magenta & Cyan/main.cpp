@@ -1,194 +1,83 @@
 #define _Alignof alignof
-#include "glad.h"
-#include "glfw3.h"
-
-#include <iostream>
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
+#include "gl_runtime.h"
 
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-const char *vertexShaderSource = "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
-    "void main()\n"
-    "{\n"
-    "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-    "}\0";
-const char *fragmentShader1Source = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(1.0f, 0.0f, 1.0f, 1.0f);\n"
-    "}\n\0";
-const char *fragmentShader2Source = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(0.0f, 1.0f, 1.0f, 1.0f);\n"
-    "}\n\0";
-
 int main()
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Tamim Iqbal", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContextSettings settings;
+    settings.width = SCR_WIDTH;
+    settings.height = SCR_HEIGHT;
+    settings.title = "Tamim Iqbal";
+    settings.closeKey = GLFW_KEY_T;
+    GlContext context;
+    if (!context.open(settings))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // build and compile our shader programs (common/include/gl_shader_variants.h)
+    // ---------------------------------------------------------------------------
+    // two variants of the stock uber-shader, each with its color compiled in: the Cyan one is
+    // submitted first and compiles while the Magenta one is built, then taken when it is needed.
+    // Where GL 4.1 program pipelines are there, the two share one vertex stage program and only
+    // their fragment stages are built, with a pipeline each instead of a second full link.
+    GlDemoShaders shaders;
+    shaders.setSeparable(true);
+    const std::string cyan = shaderFixedColor(0.0f, 1.0f, 1.0f);
+    shaders.prewarm(0, cyan);
+    const GlShaderVariant& shaderProgramMagenta = shaders.variant(0, shaderFixedColor(1.0f, 0.0f, 1.0f)); // the first program that outputs the color Magenta
+    const GlShaderVariant& shaderProgramCyan = shaders.variant(0, cyan); // the second shader program, the same vertex stage with a different color
+    if (!shaderProgramMagenta.isReady() || !shaderProgramCyan.isReady())
         return -1;
-    }
-
-
-    // build and compile our shader program
-    // ------------------------------------
-    // we skipped compile log checks this time for readability (if you do encounter issues, add the compile-checks! see previous code samples)
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    unsigned int fragmentShaderMagenta = glCreateShader(GL_FRAGMENT_SHADER); // the first fragment shader that outputs the color Magenta
-    unsigned int fragmentShaderCyan = glCreateShader(GL_FRAGMENT_SHADER); // the second fragment shader that outputs the color Cyan
-
-
-    unsigned int shaderProgramMagenta = glCreateProgram();
-    unsigned int shaderProgramCyan = glCreateProgram(); // the second shader program
- 
-
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    glShaderSource(fragmentShaderMagenta, 1, &fragmentShader1Source, NULL);
-    glCompileShader(fragmentShaderMagenta);
-    glShaderSource(fragmentShaderCyan, 1, &fragmentShader2Source, NULL);
-    glCompileShader(fragmentShaderCyan);
-
-
-    // link the first program object
-    glAttachShader(shaderProgramMagenta, vertexShader);
-    glAttachShader(shaderProgramMagenta, fragmentShaderMagenta);
-    glLinkProgram(shaderProgramMagenta);
-    // then link the second program object using a different fragment shader (but same vertex shader)
-    // this is perfectly allowed since the inputs and outputs of both the vertex and fragment shaders are equally matched.
-    glAttachShader(shaderProgramCyan, vertexShader);
-    glAttachShader(shaderProgramCyan, fragmentShaderCyan);
-    glLinkProgram(shaderProgramCyan);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
-    
+
     float firstTriangle[] = {
-        -0.5f, 0.5f, 0.0f, 
-         0.5f, -0.5f, 0.0f, 
-        -0.5f, -0.5f, 0.0f, 
+        -0.5f, 0.5f, 0.0f,
+         0.5f, -0.5f, 0.0f,
+        -0.5f, -0.5f, 0.0f,
     };
     float secondTriangle[] = {
-        -0.5f, 0.5f, 0.0f, 
-         0.5f, -0.5f, 0.0f, 
+        -0.5f, 0.5f, 0.0f,
+         0.5f, -0.5f, 0.0f,
         0.5f, 0.5f, 0.0f
     };
 
-    unsigned int VBOs[2], VAOs[2];
-    glGenVertexArrays(2, VAOs); // we can also generate multiple VAOs or buffers at the same time
-    glGenBuffers(2, VBOs);
+    GlVertexArray VAOs[2]; // one VAO (and its VBO) per triangle
     // first triangle setup
     // --------------------
-    glBindVertexArray(VAOs[0]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(firstTriangle), firstTriangle, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);	// Vertex attributes stay the same
-    glEnableVertexAttribArray(0);
-    // glBindVertexArray(0); // no need to unbind at all as we directly bind a different VAO the next few lines
+    VAOs[0].vertices(firstTriangle, sizeof(firstTriangle));
+    VAOs[0].attribute(0, 3, 3 * sizeof(float), 0);	// Vertex attributes stay the same
     // second triangle setup
     // ---------------------
-    glBindVertexArray(VAOs[1]);	// note that we bind to a different VAO now
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[1]);	// and a different VBO
-    glBufferData(GL_ARRAY_BUFFER, sizeof(secondTriangle), secondTriangle, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0); // because the vertex data is tightly packed we can also specify 0 as the vertex attribute's stride to let OpenGL figure it out
-    glEnableVertexAttribArray(0);
-    // glBindVertexArray(0); // not really necessary as well, but beware of calls that could affect VAOs while this one is bound (like binding element buffer objects, or enabling/disabling vertex attributes)
+    VAOs[1].vertices(secondTriangle, sizeof(secondTriangle));
+    VAOs[1].attribute(0, 3, 0, 0); // because the vertex data is tightly packed we can also specify 0 as the vertex attribute's stride to let OpenGL figure it out
 
     // uncomment this call to draw in wireframe polygons.
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    // both triangles go through a render queue (common/include/gl_render_queue.h): it sorts the draws
+    // by program and VAO, and only switches where they differ
+    GlRenderQueue queue;
+
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // now when we draw the triangle we first use the vertex and Magenta fragment shader from the first program
-        glUseProgram(shaderProgramMagenta);
-        // draw the first triangle using the data from our first VAO
-        glBindVertexArray(VAOs[0]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);	// this call should output an Magenta triangle
-        // then we draw the second triangle using the data from the second VAO
-        // when we draw the second triangle we want to use a different shader program so we switch to the shader program with our Cyan fragment shader.
-        glUseProgram(shaderProgramCyan);
-        glBindVertexArray(VAOs[1]);
-        glDrawArrays(GL_TRIANGLES, 0, 3);	// this call should output a Cyan triangle
-
-
-        
+        // the first triangle uses the vertex and Magenta fragment shader from the first program and the data from our first VAO
+        queue.push(GlRenderQueue::key(0, shaderProgramMagenta.name(), VAOs[0].id()), GlDrawPacket::arrays(shaderProgramMagenta.id(), VAOs[0].id(), GL_TRIANGLES, 0, 3).withPipeline(shaderProgramMagenta.pipelineId()));
+        // the second triangle uses the shader program with our Cyan fragment shader and the second VAO
+        queue.push(GlRenderQueue::key(0, shaderProgramCyan.name(), VAOs[1].id()), GlDrawPacket::arrays(shaderProgramCyan.id(), VAOs[1].id(), GL_TRIANGLES, 0, 3).withPipeline(shaderProgramCyan.pipelineId()));
+        queue.flush();	// this should output a Magenta and a Cyan triangle
+    });
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    glDeleteVertexArrays(3, VAOs);
-    glDeleteBuffers(3, VBOs);
-    glDeleteProgram(shaderProgramMagenta);
-    glDeleteProgram(shaderProgramCyan);
-
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
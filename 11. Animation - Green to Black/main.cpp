@@ -1,192 +1,130 @@
 #define _Alignof alignof       // ignore this : its just for the compiler
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
+#include "gl_animation.h"
+#include "gl_frame_capture.h"
+#include "gl_frame_stream.h"
+#include "audio_stream.h"
 
-#include <iostream>
 #include <cmath>
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
+// the color is an animation curve evaluated here (common/include/gl_animation.h): the CPU only sets the time
 const char *vertexShaderSource ="#version 330 core\n"
     "layout (location = 0) in vec3 aPos;\n"
+    "uniform float time;\n"
+    "uniform int curve;\n"
+    "uniform float pulse;\n"
+    "out vec4 ourColor;\n"
     "void main()\n"
     "{\n"
     "   gl_Position = vec4(aPos, 1.0);\n"
+    "   ourColor = mix(animationCurve(curve, time), vec4(1.0), 0.5 * pulse);\n"
     "}\0";
 
 const char *fragmentShaderSource = "#version 330 core\n"
     "out vec4 FragColor;\n"
-    "uniform vec4 ourColor;\n"
+    "in vec4 ourColor;\n"
     "void main()\n"
     "{\n"
     "   FragColor = ourColor;\n"
     "}\n\0";
 
-int main()
+int main(int argc, char** argv)
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // --capture prefix: every frame written as prefix000000.tga, ...; --video out.mp4 renders an
+    // H.264 video offline, the animation on the video's clock (common/include/gl_frame_capture.h)
+    GlFrameCapture capture;
+    capture.startFromArguments(argc, argv);
+    // --fps N (or a video's rate): the animation stepped exactly 1 / N a frame (common/include/frame_clock.h)
+    context.setFixedRate(capture.isOffline() ? capture.framesPerSecond() : fixedRateArgument(argc, argv));
+    // --pacing vsync|adaptive|low-latency|throughput|power-save [--cap N] (common/include/frame_pacer.h)
+    context.setPacing(pacingArgument(argc, argv), frameCapArgument(argc, argv));
+    // --render-thread: frames drawn on their own thread, this one only pumps the window's events (common/include/gl_context.h)
+    context.setRenderThread(renderThreadArgument(argc, argv));
+    context.setHud(hudArgument(argc, argv));
+    // --screenshot file.png [--screenshot-frame N], or F12 while it runs: a frame written in the background (common/include/gl_context.h)
+    context.screenshot(screenshotArgument(argc, argv), screenshotFrameArgument(argc, argv));
+    // --aa none|fxaa|msaa2|msaa4|msaa8: the quality tier the frames are drawn with (common/include/gl_antialias.h)
+    context.setAntialiasing(antialiasingArgument(argc, argv));
+    // --stream 8080: the frames served to browsers at http://host:8080/ as low-latency H.264, their
+    // keys and mouse sent back as the window's (common/include/gl_frame_stream.h)
+    GlFrameStream stream;
+    if (stream.startFromArguments(argc, argv))
+        context.setRemoteKeys([&stream](int key) { return stream.keyDown(key); });
+    // --audio music.wav or --beat 120: the sound device's clock drives the animation and the bass
+    // flashes the color (common/include/audio_stream.h); a video keeps to its own clock
+    AudioPlayer audio;
+    if (!capture.isOffline() && audio.startFromArguments(argc, argv))
+        context.clock().setMaster([&audio]() { return audio.time(); });
+
+    // build and compile our shader program (common/include/gl_shader.h)
+    // ------------------------------------------------------------------
+    GlProgram shaderProgram;
+    if (!shaderProgram.build(withAnimationCurves(vertexShaderSource).c_str(), fragmentShaderSource))
         return -1;
-    }
-
-    // build and compile our shader program
-    // ------------------------------------
-    // vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
     float vertices[] = {
          0.5f, -0.5f, 0.0f,  // bottom right
         -0.5f, -0.5f, 0.0f,  // bottom left
-         0.0f,  0.5f, 0.0f   // top 
+         0.0f,  0.5f, 0.0f   // top
     };
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    // glBindVertexArray(0);
+    GlVertexArray VAO;
+    VAO.vertices(vertices, sizeof(vertices));
+    VAO.attribute(0, 3, 3 * sizeof(float), 0);
 
-
-    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can 
+    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can
     // just bind it beforehand before rendering the respective triangle; this is another approach.
-    glBindVertexArray(VAO);
+    VAO.bind();
+
+    // uniform locations, looked up once instead of every frame
+    GlUniform timeUniform = shaderProgram.uniform("time");
+    GlUniform curveUniform = shaderProgram.uniform("curve");
+    GlUniform pulseUniform = shaderProgram.uniform("pulse");
 
+    // the green pulse, uploaded once: one sine period every 2π seconds
+    GlAnimationCurves curves;
+    int greenWave = curves.add(GlCurve().wave(0.0f, 0.0f, 0.0f, 1.0f,  0.0f, 1.0f, 0.0f, 1.0f,  6.2831853f));   // sin(time) / 2 + 0.5
+    curves.upload();
+    curves.bind(0);
+    shaderProgram.use();
+    shaderProgram.uniform("animationCurves").set(0);
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
         // be sure to activate the shader before any calls to glUniform
-        glUseProgram(shaderProgram);
+        shaderProgram.use();
 
-        // update shader uniform
-        double  timeValue = glfwGetTime();
-        //printf("%lf\n",timeValue);
-        float greenValue = static_cast<float>(sin(timeValue) / 2.0 + 0.5);
-        int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
-        glUniform4f(vertexColorLocation, 0.0f, greenValue, 0.0f, 1.0f);
+        // update shader uniform: the time is all the shader needs
+        timeUniform.set((float)context.time());
+        curveUniform.set(greenWave);
+        pulseUniform.set(audio.pulse(context.time()));   // 0 without audio
 
         // render the triangle
         glDrawArrays(GL_TRIANGLES, 0, 3);
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+        context.resolveFrame();   // an --aa frame into the window, where the capture reads it
+        capture.frame();   // read back a few frames later, never waited for
+        stream.frame(context.onMainThread() ? context.window() : NULL);
+    });
 
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
-
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
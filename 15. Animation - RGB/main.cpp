@@ -1,218 +1,150 @@
 #define _Alignof alignof       // ignore this : its just for the compiler
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
+#include "gl_animation.h"
+#include "gl_frame_capture.h"
+#include "gl_frame_stream.h"
+#include "audio_stream.h"
 
-#include <iostream>
 #include <cmath>
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
+// the color is an animation curve evaluated here (common/include/gl_animation.h): the CPU only sets the time
 const char *vertexShaderSource ="#version 330 core\n"
     "layout (location = 0) in vec3 aPos;\n"
+    "uniform float time;\n"
+    "uniform int curve;\n"
+    "uniform float pulse;\n"
+    "out vec4 ourColor;\n"
     "void main()\n"
     "{\n"
     "   gl_Position = vec4(aPos, 1.0);\n"
+    "   ourColor = mix(animationCurve(curve, time), vec4(1.0), 0.5 * pulse);\n"
     "}\0";
 
 const char *fragmentShaderSource = "#version 330 core\n"
     "out vec4 FragColor;\n"
-    "uniform vec4 ourColor;\n"
+    "in vec4 ourColor;\n"
     "void main()\n"
     "{\n"
     "   FragColor = ourColor;\n"
     "}\n\0";
 
-int main()
+int main(int argc, char** argv)
 {
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // --capture prefix: every frame written as prefix000000.tga, ...; --video out.mp4 renders an
+    // H.264 video offline, the animation on the video's clock (common/include/gl_frame_capture.h)
+    GlFrameCapture capture;
+    capture.startFromArguments(argc, argv);
+    // --fps N (or a video's rate): the animation stepped exactly 1 / N a frame (common/include/frame_clock.h)
+    context.setFixedRate(capture.isOffline() ? capture.framesPerSecond() : fixedRateArgument(argc, argv));
+    // --pacing vsync|adaptive|low-latency|throughput|power-save [--cap N] (common/include/frame_pacer.h)
+    context.setPacing(pacingArgument(argc, argv), frameCapArgument(argc, argv));
+    // --render-thread: frames drawn on their own thread, this one only pumps the window's events (common/include/gl_context.h)
+    context.setRenderThread(renderThreadArgument(argc, argv));
+    context.setHud(hudArgument(argc, argv));
+    // --screenshot file.png [--screenshot-frame N], or F12 while it runs: a frame written in the background (common/include/gl_context.h)
+    context.screenshot(screenshotArgument(argc, argv), screenshotFrameArgument(argc, argv));
+    // --aa none|fxaa|msaa2|msaa4|msaa8: the quality tier the frames are drawn with (common/include/gl_antialias.h)
+    context.setAntialiasing(antialiasingArgument(argc, argv));
+    // --stream 8080: the frames served to browsers at http://host:8080/ as low-latency H.264, their
+    // keys and mouse sent back as the window's (common/include/gl_frame_stream.h)
+    GlFrameStream stream;
+    if (stream.startFromArguments(argc, argv))
+        context.setRemoteKeys([&stream](int key) { return stream.keyDown(key); });
+    // --audio music.wav or --beat 120: the sound device's clock drives the animation and the bass
+    // flashes the color (common/include/audio_stream.h); a video keeps to its own clock
+    AudioPlayer audio;
+    if (!capture.isOffline() && audio.startFromArguments(argc, argv))
+        context.clock().setMaster([&audio]() { return audio.time(); });
+
+    // build and compile our shader program (common/include/gl_shader.h)
+    // ------------------------------------------------------------------
+    GlProgram shaderProgram;
+    if (!shaderProgram.build(withAnimationCurves(vertexShaderSource).c_str(), fragmentShaderSource))
         return -1;
-    }
-
-    // build and compile our shader program
-    // ------------------------------------
-    // vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
     float vertices[] = {
          0.5f, -0.5f, 0.0f,  // bottom right
         -0.5f, -0.5f, 0.0f,  // bottom left
-         0.0f,  0.5f, 0.0f   // top 
+         0.0f,  0.5f, 0.0f   // top
     };
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    // glBindVertexArray(0);
-
+    GlVertexArray VAO;
+    VAO.vertices(vertices, sizeof(vertices));
+    VAO.attribute(0, 3, 3 * sizeof(float), 0);
 
-    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can 
+    // bind the VAO (it was already bound, but just to demonstrate): seeing as we only have a single VAO we can
     // just bind it beforehand before rendering the respective triangle; this is another approach.
-    glBindVertexArray(VAO);
-
+    VAO.bind();
+
+    // uniform locations, looked up once instead of every frame
+    GlUniform timeUniform = shaderProgram.uniform("time");
+    GlUniform curveUniform = shaderProgram.uniform("curve");
+    GlUniform pulseUniform = shaderProgram.uniform("pulse");
+
+    // RbGbBb, uploaded once: six phases of 3 seconds; red, green and blue each fade in and out
+    // (sin(progress * π / 3) over the phase) in phases 0, 2 and 4, black during the others
+    GlAnimationCurves curves;
+    GlCurve phases;
+    phases.loop(18.0f);
+    for (int channel = 0; channel < 3; ++channel)
+    {
+        float start = 6.0f * channel;
+        float peak[3] = { 0.0f, 0.0f, 0.0f };
+        peak[channel] = 1.0f;
+        phases.key(start, 0.0f, 0.0f, 0.0f, 1.0f, EASE_OUT_SINE)
+              .key(start + 1.5f, peak[0], peak[1], peak[2], 1.0f, EASE_IN_SINE)
+              .key(start + 3.0f, 0.0f, 0.0f, 0.0f, 1.0f, EASE_STEP);
+    }
+    int rgbPhases = curves.add(phases);
+    curves.upload();
+    curves.bind(0);
+    shaderProgram.use();
+    shaderProgram.uniform("animationCurves").set(0);
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
         // be sure to activate the shader before any calls to glUniform
-        glUseProgram(shaderProgram);
+        shaderProgram.use();
 
-        // update shader uniform
-        double  timeValue = glfwGetTime();
+        // update shader uniform: the time is all the shader needs
+        timeUniform.set((float)context.time());
+        curveUniform.set(rgbPhases);
+        pulseUniform.set(audio.pulse(context.time()));   // 0 without audio
 
         // RGB -> Rainbow
         //printf("%lf\n",timeValue);
         // float redValue   = static_cast<float>(sin(timeValue * 0.5) * 0.5 + 0.5);
         // float greenValue = static_cast<float>(sin(timeValue * 0.5 + 2.0) * 0.5 + 0.5);
         // float blueValue  = static_cast<float>(sin(timeValue * 0.5 + 4.0) * 0.5 + 0.5);
-        // int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
-        // glUniform4f(vertexColorLocation, redValue, greenValue, blueValue, 1.0f);
-        
-        // RbGbBb
-        float t = static_cast<float>(glfwGetTime());
-        int phase = static_cast<int>(t / 3.0f) % 6; // each phase lasts 2 seconds
-        float progress = fmod(t, 3.0f);             // range: 0.0 - 2.0
-        float anim = sin(progress * 3.14159f / 3.0f); // smoother sin fade (0 → 1 → 0 over 2s)
-
-        float red = 0.0f, green = 0.0f, blue = 0.0f;
-
-        if (phase == 0)
-            red = anim;
-        else if (phase == 2)
-            green = anim;
-        else if (phase == 4)
-            blue = anim;
-        // black during other phases
-
-        int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
-        glUniform4f(vertexColorLocation, red, green, blue, 1.0f);
-
+        // ourColor.set(redValue, greenValue, blueValue, 1.0f);
 
-            
 
         // render the triangle
         glDrawArrays(GL_TRIANGLES, 0, 3);
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+        context.resolveFrame();   // an --aa frame into the window, where the capture reads it
+        capture.frame();   // read back a few frames later, never waited for
+        stream.frame(context.onMainThread() ? context.window() : NULL);
+    });
 
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
@@ -1,216 +1,116 @@
 #define _Alignof alignof
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
 
 #include <bits/stdc++.h>
+#include "raster_dda.h"
+#include "raster_trace.h"
+#include "gpu_lines.h"
+#include "gl_point_cloud.h"
 using namespace std;
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-const char *vertexShaderSource = "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
-    "void main()\n"
-    "{\n"
-    "gl_PointSize= 5.0f;\n"
-    "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-    "}\0";
-const char *fragmentShaderSource = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(1.0f, 0.0f, 0.0f, 1.0f);\n" //triangle color red
-    "}\n\0";
-
-vector<float>DDA (float x0, float y0, float x1, float y1)
+int main(int argc, char** argv)
 {
-    float dx, dy;
-
-    vector<float>points;
-
-    if(x1 < x0)
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    // --cloud scan.pcloud draws a point cloud of any size instead of the line (common/include/gl_point_cloud.h,
+    // built by common/tools/point_cloud_build): streamed from disk a quadtree node at a time, refined where the
+    // view needs the points; the arrow keys pan, Z and X zoom. --splat draws it with compute shaders (GL 4.3)
+    const char* cloudPath = cloudArgument(argc, argv);
+    const bool splat = splatArgument(argc, argv);
+    GlContextSettings settings;
+    settings.width = SCR_WIDTH;
+    settings.height = SCR_HEIGHT;
+    settings.title = "LearnOpenGL";
+    if (splat)
     {
-        swap(x0, x1);
-        swap(y0, y1);
-    }
-    dx = x1 - x0;
-    dy = y1 - y0;
-
-    int stepSize = max(dx,dy);
-    float xinc = dx / stepSize;
-    float yinc = dy / stepSize;
-
-    for(int i=0; i<=stepSize; i++)
-    {
-
-        points.push_back(x0/10.0);
-        points.push_back(y0/10.0);        
-        points.push_back(0.0f);
-
-        cout << x0 << " " << y0 << endl;        
-
-        x0 += xinc;
-        y0 += yinc;
+        settings.major = 4;
+        settings.minor = 3;
     }
-
-    return points;
-}
-int main()
-{
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    GlContext context;
+    if (!context.open(settings))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    context.setTrace(traceArgument(argc, argv));   // --trace file.json: the rasterizer scopes below and the first frames
 
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // the 16.16 fixed-point DDA (common/include/gpu_lines.h) runs in the vertex shader: only the
+    // endpoints are uploaded and every point computes its own pixel, scaled from the grid to NDC (1/10)
+    GpuLineRenderer lines;
+    if (!lines.init())
         return -1;
-    }
-
+    DDALine line = {2.0f, 2.0f, 8.0f, 6.0f};
+    lines.ddaLine(line.x0, line.y0, line.x1, line.y1);
+    lines.upload();
+    lines.setTransform(0.1f, 0.1f);
+    lines.setColor(1.0f, 0.0f, 0.0f);
+    lines.setPointSize(5.0f);
+    glEnable(GL_PROGRAM_POINT_SIZE);
 
-    // build and compile our shader program
-    // ------------------------------------
-    // vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // the point dump is a trace: RASTER_TRACE=2 ./app prints the pixels, buffered; the GPU's
+    // points are the same, so the CPU DDA only runs for the trace
+    RasterTrace trace(stdout);
+    if (trace.level() != RASTER_TRACE_OFF)
     {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        auto discard = [](const RasterSpan&) {};
+        RasterTraced<decltype(discard)> traced(discard, trace);
+        rasterizeDDA(line.x0, line.y0, line.x1, line.y1, traced);
+        trace.flush();
     }
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // set up vertex data (and buffer(s)) and configure vertex attributes
-    // ------------------------------------------------------------------
-    vector<float>vertices = DDA(2.0f,2.0f,8.0f,6.0f);
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glEnable(GL_PROGRAM_POINT_SIZE);
-
-    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0); 
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    glBindVertexArray(0); 
 
+    GlPointCloud cloud;
+    if (cloudPath && !cloud.open(cloudPath))
+        return -1;
+    if (splat && cloud.isOpen() && !cloud.splatSupported())
+        std::cout << "no compute shaders (GL " << context.version() << "): the cloud is drawn as points" << std::endl;
+    PointCloudView view = cloud.isOpen() ? cloud.fit(SCR_WIDTH, SCR_HEIGHT) : PointCloudView();
+    double lastTime = 0.0;
 
     // uncomment this call to draw in wireframe polygons.
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        if (cloud.isOpen())
+        {
+            const double now = context.time();
+            const float step = (float)std::min(now - lastTime, 0.1);
+            lastTime = now;
+            GLint viewport[4];
+            glGetIntegerv(GL_VIEWPORT, viewport);
+            view.width = std::max(viewport[2], 1);
+            view.height = std::max(viewport[3], 1);
+            const float pan = 400.0f * view.unitsPerPixel * step;   // 400 pixels a second
+            view.centerX += pan * ((context.keyDown(GLFW_KEY_RIGHT) ? 1 : 0) - (context.keyDown(GLFW_KEY_LEFT) ? 1 : 0));
+            view.centerY += pan * ((context.keyDown(GLFW_KEY_UP) ? 1 : 0) - (context.keyDown(GLFW_KEY_DOWN) ? 1 : 0));
+            if (context.keyDown(GLFW_KEY_Z))
+                view.unitsPerPixel *= std::pow(0.25f, step);   // four times closer a second
+            if (context.keyDown(GLFW_KEY_X))
+                view.unitsPerPixel *= std::pow(4.0f, step);
+            cloud.update(view);
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glEnable(GL_DEPTH_TEST);
+            if (!splat || !cloud.splat(view))
+                cloud.draw(view);
+            glDisable(GL_DEPTH_TEST);
+            return;
+        }
         glClear(GL_COLOR_BUFFER_BIT);
 
-        // draw our first triangle
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-        glDrawArrays(GL_POINTS, 0,vertices.size() / 3);
-        // glBindVertexArray(0); // no need to unbind it every time 
- 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+        lines.draw();
+    });
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+    lines.release();
+    cloud.close();
 
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
 }
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
-}
@@ -1,216 +1,97 @@
 #define _Alignof alignof
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
 
 #include <bits/stdc++.h>
+#include "raster_dda.h"
+#include "raster_trace.h"
+#include "raster_aa.h"
+#include "soft_present.h"
+#include "gl_stroke.h"
 using namespace std;
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-const char *vertexShaderSource = "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
-    "void main()\n"
-    "{\n"
-    "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-    "}\0";
-const char *fragmentShaderSource = "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(1.0f, 0.0f, 0.0f, 1.0f);\n" //triangle color red
-    "}\n\0";
-
-vector<float>DDA (float x0, float y0, float x1, float y1)
+int main(int argc, char** argv)
 {
-    float dx, dy;
-
-    vector<float>points;
-
-    if(x1 < x0)
-    {
-        swap(x0, x1);
-        swap(y0, y1);
-    }
-    dx = x1 - x0;
-    dy = y1 - y0;
-
-    int stepSize = max(dx,dy);
-    float xinc = dx / stepSize;
-    float yinc = dy / stepSize;
-
-    for(int i=0; i<=stepSize; i++)
-    {
-
-        points.push_back(x0/10.0);
-        points.push_back(y0/10.0);        
-        points.push_back(0.0f);
-
-        cout << x0 << " " << y0 << endl;        
-
-        x0 += xinc;
-        y0 += yinc;
-    }
-
-    return points;
-}
-int main()
-{
-    // glfw: initialize and configure
-    // ------------------------------
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    // glfw window creation
-    // --------------------
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    // glad: load all OpenGL function pointers
-    // ---------------------------------------
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    context.setTrace(traceArgument(argc, argv));   // --trace file.json: the rasterizer scopes below and the first frames
+
+    // glLineWidth(5.0f) does nothing on a core profile (only width 1 has to be supported), so the
+    // line is drawn on the CPU instead: a 5 pixel wide antialiased line (common/include/raster_aa.h)
+    // into a software framebuffer of window size, shown as one textured draw
+    SoftFramebuffer framebuffer;
+    framebuffer.resize(SCR_WIDTH, SCR_HEIGHT);
+    SoftPresenter presenter;
+    if (!presenter.init())
         return -1;
-    }
-
 
-    // build and compile our shader program
-    // ------------------------------------
-    // vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // check for shader compile errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // check for shader compile errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // the 16.16 fixed-point DDA (common/include/raster_dda.h) gives the points of the line on the
+    // grid; the point dump is a trace: RASTER_TRACE=2 ./app prints the pixels, buffered
+    DDALine line = {0.0f, 0.0f, 5.0f, 5.0f};
+    vector<float> points;
+    RasterTrace trace(stdout);
+    auto collect = rasterPixels([&](int x, int y) { points.push_back((float)x); points.push_back((float)y); });
+    RasterTraced<decltype(collect)> traced(collect, trace);
+    rasterizeDDA(line.x0, line.y0, line.x1, line.y1, traced);
+    trace.flush();
+
+    // the points joined as before, one grid unit being 1/10 of the window (what the NDC scale was)
+    framebuffer.clear(rgba(255, 255, 255));
+    RasterViewport screen = {0, 0, (int)SCR_WIDTH - 1, (int)SCR_HEIGHT - 1};
+    auto toPixelX = [](float x) { return SCR_WIDTH * (0.5f + 0.05f * x); };
+    auto toPixelY = [](float y) { return SCR_HEIGHT * (0.5f + 0.05f * y); };
+    for (size_t i = 2; i < points.size(); i += 2)
+        rasterizeWideLine(toPixelX(points[i - 2]), toPixelY(points[i - 1]), toPixelX(points[i]), toPixelY(points[i + 1]),
+                          5.0, screen, framebuffer.pen(rgba(255, 0, 0)));
+
+    // --stroke: the same 5 pixel line as triangles on the GPU instead (common/include/gl_stroke.h),
+    // a stroke with round joins and caps through a 2D batch in window pixels
+    bool gpuStroke = false;
+    for (int i = 1; i < argc; ++i)
+        gpuStroke = gpuStroke || strcmp(argv[i], "--stroke") == 0;
+    GlBatch2D batch;
+    if (gpuStroke && !batch.open())
+        return -1;
+    batch.setProjection(0.0f, (float)SCR_WIDTH, 0.0f, (float)SCR_HEIGHT);
+    vector<float> polyline;
+    for (size_t i = 0; i + 1 < points.size(); i += 2)
     {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    // link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // check for linking errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        polyline.push_back(toPixelX(points[i]));
+        polyline.push_back(toPixelY(points[i + 1]));
     }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // set up vertex data (and buffer(s)) and configure vertex attributes
-    // ------------------------------------------------------------------
-    vector<float>vertices = DDA(0.0f,0.0f,5.0f,5.0f);
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glEnable(GL_PROGRAM_POINT_SIZE);
-
-    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0); 
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    glBindVertexArray(0); 
-
-
-    // uncomment this call to draw in wireframe polygons.
-    //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    GlStroker stroker;
+    GlStrokeStyle style;
+    style.width = 5.0f;
+    style.join = JOIN_ROUND;
+    style.cap = CAP_ROUND;
 
     // render loop
     // -----------
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        // input
-        // -----
-        processInput(window);
-
         // render
         // ------
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // draw our first triangle
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-        glLineWidth(5.0f);
-        glDrawArrays(GL_LINE_STRIP, 0,vertices.size() / 3);
-        // glBindVertexArray(0); // no need to unbind it every time 
- 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+        if (gpuStroke)
+        {
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            stroker.stroke(batch, polyline.data(), (int)polyline.size() / 2, style, GlBatch2D::rgba(1.0f, 0.0f, 0.0f));
+            batch.flush();
+        }
+        else
+            presenter.present(framebuffer);   // uploads only the rows that changed, here none after the first frame
+    });
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+    presenter.release();
+    batch.release();
 
-    // glfw: terminate, clearing all previously allocated GLFW resources.
-    // ------------------------------------------------------------------
-    glfwTerminate();
     return 0;
-}
-
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-// ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
 }
\ No newline at end of file
@@ -1,24 +1,20 @@
 #define _Alignof alignof
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
 
-#include <iostream>
-#include <vector>
 #include <cmath>
+#include "raster_segment_store.h"
 using namespace std;
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
 const char *vertexShaderSource = "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
+    "layout (location = 0) in ivec2 aPixel;\n"   // packed int16 pixel coordinates
+    "uniform vec2 pixelScale;\n"
     "void main()\n"
     "{\n"
     "   gl_PointSize = 5.0f;\n"
-    "   gl_Position = vec4(aPos, 1.0);\n"
+    "   gl_Position = vec4(vec2(aPixel) * pixelScale, 0.0, 1.0);\n"
     "}\0";
 
 const char *fragmentShaderSource = "#version 330 core\n"
@@ -28,171 +24,99 @@ const char *fragmentShaderSource = "#version 330 core\n"
     "   FragColor = vec4(1.0, 0.0, 0.0, 1.0);\n"
     "}\0";
 
-// Bresenham's algorithm for slope between 0 and 1
-std::vector<float> bresenhamVariantLine(int x0, int y0, int x1, int y1) {
-    std::vector<float> points;
-
-    // Ensure left to right drawing
-    if (x0 > x1) {
-        std::swap(x0, x1);
-        std::swap(y0, y1);
-    }
-
-    int dx = x1 - x0;
-    int dy = y1 - y0;
-
-    int d = 2 * dy - dx;
-    int dT = 2 * (dy - dx);
-    int dS = 2 * dy;
-
-    int x = x0;
-    int y = y0;
-
-    int xmin = std::min(x0, x1);
-    int xmax = std::max(x0, x1);
-    int ymin = std::min(y0, y1);
-    int ymax = std::max(y0, y1);
-
-    while (x <= x1) {
-        //float ndc_x = 2.0f * (x - xmin) / float(xmax - xmin) - 1.0f;
-        //float ndc_y = 2.0f * (y - ymin) / float(ymax - ymin) - 1.0f;
-
-        points.push_back(x/10.0);
-        points.push_back(y/10.0);
-        points.push_back(0.0f);
+// Bresenham's algorithm for all eight octants, clipped to the grid first (see common/include/raster_line.h),
+// run by the segment store: every line keeps its own range of the point buffer, so dragging an end with the
+// left mouse button re-rasterizes and uploads that line alone (common/include/raster_segment_store.h)
+struct LineEditor {
+    GlContext* context = NULL;
+    RasterSegmentStore* segments = NULL;
+    int dragged = -1;               // the segment whose end follows the cursor
+};
+static LineEditor editor;
+
+// the grid point under the cursor; the shader maps the [-10, 10] grid onto the window
+static void cursorPoint(GLFWwindow* window, double cursorX, double cursorY, int& x, int& y) {
+    int width = 1, height = 1;
+    glfwGetWindowSize(window, &width, &height);
+    x = (int)std::lround((cursorX / std::max(width, 1) * 2.0 - 1.0) * 10.0);
+    y = (int)std::lround((1.0 - cursorY / std::max(height, 1) * 2.0) * 10.0);
+}
 
-        if (d < 0) {
-            d += dS;
-        } else {
-            d += dT;
-            y++;
+static void mouseButton(GLFWwindow* window, int button, int action, int) {
+    if (button != GLFW_MOUSE_BUTTON_LEFT)
+        return;
+    editor.dragged = -1;
+    if (action != GLFW_PRESS)
+        return;
+    double cursorX, cursorY;
+    int x, y, x0, y0, x1, y1, nearest = 3 * 3;   // picks ends within 3 grid steps
+    glfwGetCursorPos(window, &cursorX, &cursorY);
+    cursorPoint(window, cursorX, cursorY, x, y);
+    for (size_t id = 0; id < editor.segments->ids(); ++id)
+        if (editor.segments->segment(id, x0, y0, x1, y1) && (x1 - x) * (x1 - x) + (y1 - y) * (y1 - y) < nearest) {
+            nearest = (x1 - x) * (x1 - x) + (y1 - y) * (y1 - y);
+            editor.dragged = (int)id;
         }
-        x++;
-    }
+}
 
-    return points;
+static void cursorMoved(GLFWwindow* window, double cursorX, double cursorY) {
+    int x, y, x0, y0, x1, y1;
+    if (editor.dragged < 0 || !editor.segments->segment(editor.dragged, x0, y0, x1, y1))
+        return;
+    cursorPoint(window, cursorX, cursorY, x, y);
+    if (x == x1 && y == y1)
+        return;
+    editor.segments->move(editor.dragged, x0, y0, x, y);
+    editor.context->invalidate();   // the frame is static otherwise
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Bresenham Points", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "Bresenham Points"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    context.setTrace(traceArgument(argc, argv));   // --trace file.json: the rasterizer scopes below and the first frames
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // build and compile our shader program (common/include/gl_shader.h)
+    // ------------------------------------------------------------------
+    GlProgram shaderProgram;
+    if (!shaderProgram.build(vertexShaderSource, fragmentShaderSource))
         return -1;
-    }
-
-    // Compile shaders
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
 
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "Vertex shader compilation failed:\n" << infoLog << std::endl;
-    }
-
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "Fragment shader compilation failed:\n" << infoLog << std::endl;
+    // Generate points using the Bresenham engine: a star of lines through every octant, reaching past the
+    // edge of the [-10, 10] grid so the clipping shows
+    RasterViewport grid = { -10, -10, 10, 10 };
+    const int LINES = 16;
+    RasterSegmentStore segments(grid);
+    for (int i = 0; i < LINES; ++i) {
+        float angle = i * 2.0f * M_PI / LINES;
+        segments.add(0, 0, (int)std::lround(14.0f * cos(angle)), (int)std::lround(14.0f * sin(angle)));
     }
-
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "Shader linking failed:\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // Generate points using the modified Bresenham algorithm
-    std::vector<float> linePoints = bresenhamVariantLine(0, 0, 5, 5);
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, linePoints.size() * sizeof(float), linePoints.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    editor.context = &context;
+    editor.segments = &segments;
+    glfwSetMouseButtonCallback(context.window(), mouseButton);
+    glfwSetCursorPosCallback(context.window(), cursorMoved);
+
+    // the pixels go into the vertex buffer as packed int16 (x, y) pairs, 4 bytes a point; the shader
+    // scales them to clip space (x / 10, y / 10)
+    GlSegmentBuffer linePoints;
     glEnable(GL_PROGRAM_POINT_SIZE);
-
+    shaderProgram.use();
+    glUniform2f(shaderProgram.location("pixelScale"), 0.1f, 0.1f);
 
     // Render loop
-    while (!glfwWindowShouldClose(window))
+    context.run([&]()
     {
-        processInput(window);
-
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_LINE_STRIP, 0, linePoints.size() / 3);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+        shaderProgram.use();
+        linePoints.upload(segments);   // the ranges of the lines moved since the last frame
+        linePoints.draw();
+    });
 
-    glfwTerminate();
     return 0;
 }
 
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}
-
-
-
-
-
-
-
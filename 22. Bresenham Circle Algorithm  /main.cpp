@@ -1,196 +1,48 @@
 #define _Alignof alignof
-#include "glad.h"
-#include "glfw3.h"
+#include "gl_runtime.h"
 
-#include <iostream>
-#include <vector>
 #include <cmath>
+#include "raster_constexpr.h"
+#include "soft_present.h"
 
 using namespace std;
 
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
-
 // Screen settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// Vertex Shader
-const char *vertexShaderSource = R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-void main()
-{
-    gl_PointSize = 2.0f;
-    gl_Position = vec4(aPos, 1.0);
-}
-)";
-
-// Fragment Shader
-const char *fragmentShaderSource = R"(
-#version 330 core
-out vec4 FragColor;
-void main()
-{
-    FragColor = vec4(1.0, 0.0, 0.0, 1.0);
-}
-)";
-
-// Convert screen coordinates to NDC
-std::pair<float, float> toNDC(float x, float y) {
-    float ndc_x = (2.0f * x / SCR_WIDTH) - 1.0f;
-    float ndc_y = (2.0f * y / SCR_HEIGHT) - 1.0f;
-    return {ndc_x, ndc_y};
-}
-
-// Generate 8 symmetric points of the circle
-std::vector<float> symmetricPoint(float cx, float cy, float x, float y) {
-    std::vector<float> v;
-    float dx[] = {x, -x, -x, x, y, -y, -y, y};
-    float dy[] = {y, y, -y, -y, x, x, -x, -x};
-    for (int i = 0; i < 8; i++) {
-        pair<float,float> ndc = toNDC(cx + dx[i], cy + dy[i]);
-        v.push_back(ndc.first);
-        v.push_back(ndc.second);
-        v.push_back(0.0f);
-    }
-    return v;
-}
-
-// Bresenham circle point generation in NDC
-std::vector<float> bresenhamCircle(float cx, float cy, float radius) {
-    std::vector<float> points;
-    float x = 0;
-    float y = radius;
-    float d = 3 - 2 * radius;                 // mid point : d = 1 - r
-
-    while (x <= y) {
-        std::vector<float> symPoints = symmetricPoint(cx, cy, x, y);
-        points.insert(points.end(), symPoints.begin(), symPoints.end());
-
-        if (d < 0)
-            d += 4 * x + 6;                  // 2x + 3
-        else {
-            d += 4 * (x - y) + 10;           // 2(x-y) + 5
-            y--;
-        }
-        x++;
-    }
-
-    return points;
-}
-
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Bresenham Circle (Modern OpenGL)", NULL, NULL);
-    if (!window) {
-        cout << "Failed to create GLFW window" << endl;
-        glfwTerminate();
+int main(int argc, char** argv) {
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "Bresenham Circle (Modern OpenGL)"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        cout << "Failed to initialize GLAD" << endl;
+    context.setTrace(traceArgument(argc, argv));   // --trace file.json: the rasterizer scopes below and the first frames
+
+    // The circle is drawn on the CPU into a software framebuffer of window size (one texel per
+    // pixel) and shown as a single textured draw, instead of one GL_POINTS vertex per pixel
+    SoftFramebuffer framebuffer;
+    framebuffer.resize(SCR_WIDTH, SCR_HEIGHT);
+    SoftPresenter presenter;
+    if (!presenter.init())
         return -1;
-    }
-
-    // Compile shaders
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        cout << "Vertex Shader Error:\n" << infoLog << endl;
-    }
 
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        cout << "Fragment Shader Error:\n" << infoLog << endl;
+    // Circle data: the integer midpoint circle is fixed, so the compiler rasterizes it
+    // (common/include/raster_constexpr.h) and the program only copies its pixels
+    static constexpr auto circle = rasterCircleTable<400, 300, 100>(); // Center at (400,300), radius 100
+    framebuffer.clear(rgba(25, 25, 25));
+    auto pen = framebuffer.pen(rgba(255, 0, 0));
+    for (const RasterPoint& point : circle) {
+        RasterSpan pixel = { point.x, point.y, 1, false };
+        pen(pixel);
     }
 
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        cout << "Shader Linking Error:\n" << infoLog << endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // Circle data
-    std::vector<float> circlePoints = bresenhamCircle(400, 300, 100); // Center at (400,300), radius 100
-
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, circlePoints.size() * sizeof(float), circlePoints.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glEnable(GL_PROGRAM_POINT_SIZE);
-
     // Render loop
-    while (!glfwWindowShouldClose(window)) {
-        processInput(window);
-
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_POINTS, 0, circlePoints.size() / 3);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+    context.run([&]() {
+        presenter.present(framebuffer);   // uploads only the rows that changed, here none after the first frame
+    });
 
     // Cleanup
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
-
-    glfwTerminate();
+    presenter.release();
     return 0;
 }
-
-void processInput(GLFWwindow *window) {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
-}
-
-
-
-
-
-
-
-
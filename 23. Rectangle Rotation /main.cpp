@@ -1,100 +1,46 @@
 #define _Alignof alignof       // ignore this : its just for the compiler
-#include "glad.h"
-#include "glfw3.h"
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include "gl_runtime.h"
+#include "mesh_index.h"
 
 #include "glm/glm/glm.hpp"
 #include "glm/glm/gtc/matrix_transform.hpp"
 #include "glm/glm/gtc/type_ptr.hpp"
+#include "affine2d.h"
+#include "keyframe_timeline.h"
 
 #include "shader_m.h"
-#include <iostream>
-
-const char* vertexShaderSource = "#version 330 core\n"
-"layout (location = 0) in vec3 aPos;\n"
-"uniform mat4 transform;\n"
-"void main()\n"
-"{\n"
-"   gl_Position = transform * vec4(aPos, 1.0);\n"
-"}\0";
-
-const char* fragmentShaderSource = "#version 330 core\n"
-"out vec4 FragColor;\n"
-"void main()\n"
-"{\n"
-"   FragColor = vec4(1.0, 1.0, 0.0, 1.0);\n"
-"}\0";
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window);
 
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-int main()
+int main(int argc, char** argv)
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Rotating Yellow Rectangle", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
+    // glfw, the window and glad (common/include/gl_context.h)
+    // --------------------------------------------------------
+    GlContext context;
+    if (!context.open(SCR_WIDTH, SCR_HEIGHT, "Rotating Yellow Rectangle"))
         return -1;
-    }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+    // --fps N: deterministic offline mode, the animation stepped exactly 1 / N a frame (common/include/frame_clock.h)
+    context.setFixedRate(fixedRateArgument(argc, argv));
+    // --pacing vsync|adaptive|low-latency|throughput|power-save [--cap N] (common/include/frame_pacer.h)
+    context.setPacing(pacingArgument(argc, argv), frameCapArgument(argc, argv));
+    // --render-thread: frames drawn on their own thread, this one only pumps the window's events (common/include/gl_context.h)
+    context.setRenderThread(renderThreadArgument(argc, argv));
+    context.setHud(hudArgument(argc, argv));
+    // --screenshot file.png [--screenshot-frame N], or F12 while it runs: a frame written in the background (common/include/gl_context.h)
+    context.screenshot(screenshotArgument(argc, argv), screenshotFrameArgument(argc, argv));
+    // --aa none|fxaa|msaa2|msaa4|msaa8: the quality tier the frames are drawn with (common/include/gl_antialias.h)
+    context.setAntialiasing(antialiasingArgument(argc, argv));
+
+    // build and compile our shader program (common/include/gl_shader_variants.h)
+    // ------------------------------------------------------------------
+    GlDemoShaders shaders;   // the stock uber-shader's variant with a transform, its color compiled in
+    const GlShaderVariant& shaderProgram = shaders.variant(SHADER_TRANSFORM, shaderFixedColor(1.0f, 1.0f, 0.0f));   // yellow
+    if (!shaderProgram.isReady())
         return -1;
-    }
-
-    // Compile vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // Compile fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // Link shaders
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // New: 6 vertices for 2 triangles (no EBO)
+
+    // 6 vertices for 2 triangles, indexed below
     float vertices[] = {
         // First triangle
          0.5f,  0.5f, 0.0f,  // top right
@@ -103,62 +49,46 @@ int main()
         // Second triangle
          0.5f,  0.5f, 0.0f,  // top right
         -0.5f, -0.5f, 0.0f,  // bottom left
-        -0.5f,  0.5f, 0.0f   // top left 
+        -0.5f,  0.5f, 0.0f   // top left
     };
 
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
+    // the two triangles share two corners: welded, that is 4 vertices and 6 indices (common/include/mesh_index.h)
+    IndexedMesh quad = weldVertices(vertices, 6, 3);
+    optimizeVertexCache(quad.indices.data(), quad.indices.size(), quad.vertexCount());
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    GlVertexArray VAO;
+    VAO.vertices(quad.vertices.data(), quad.vertices.size() * sizeof(float));
+    VAO.indices(quad.indices.data(), quad.indices.size() * sizeof(unsigned int));
 
     // Vertex attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    VAO.attribute(0, 3, 3 * sizeof(float), 0);
 
-    while (!glfwWindowShouldClose(window))
-    {
-        processInput(window);
+    // uniform locations, looked up once instead of every frame
+    GlUniform transformUniform = shaderProgram.uniform("transform");   // one 4x4 matrix, no transpose needed
 
+    // one turn a period of 2π seconds, as a looping keyframe track (common/include/keyframe_timeline.h)
+    KeyframeTimeline timeline;
+    int angle = timeline.addTrack({ { 0.0f, 0.0f }, { 6.2831853f, 6.2831853f } }, 6.2831853f);
+
+    context.run([&]()
+    {
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        glUseProgram(shaderProgram);
+        shaderProgram.use();
 
-        glm::mat4 transform = glm::mat4(1.0f); //4x4 matrix in opengl --> set initially identity matrix,
-        transform = glm::rotate(transform,(float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));//0, 0, 1) means rotate around the Z-axis, which is perpendicular to the screen.In 2D, this gives the impression of spinning in place.
+        // the 4x4 rotation about the Z-axis, written straight from the angle (common/include/affine2d.h)
+        // instead of glm::rotate multiplying it into an identity matrix
+        timeline.sample((float)context.time());
+        float transform[16];
+        affine2DMatrix4(0.0f, 0.0f, timeline.value(angle), 1.0f, 1.0f, transform);
         //The Z-axis points out of the screen, so the rotation happens in the XY plane.
 
+        transformUniform.setMatrix4(transform);
 
+        VAO.bind();
+        glDrawElements(GL_TRIANGLES, (GLsizei)quad.indices.size(), GL_UNSIGNED_INT, 0); // 2 triangles, 6 indices
+    });
 
-        unsigned int transformLoc = glGetUniformLocation(shaderProgram, "transform");
-        glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));//1 matrix, no transpose needed
-
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6); // Draw 6 vertices (2 triangles)
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
-
-    glfwTerminate();
     return 0;
 }
-
-void processInput(GLFWwindow *window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-}
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}